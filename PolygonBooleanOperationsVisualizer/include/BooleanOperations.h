@@ -2,11 +2,15 @@
 
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
 #include <CGAL/Boolean_set_operations_2.h>
+#include <CGAL/Polygon_set_2.h>
 #include <vector>
 #include <list>
 #include <utility>
 #include <string>
 #include <exception>
+#include <functional>
+
+class ResultCache;
 
 class BooleanOperations {
 public:
@@ -19,6 +23,16 @@ public:
     typedef CGAL::Polygon_2<Kernel> Polygon_2;
     typedef CGAL::Polygon_with_holes_2<Kernel> Polygon_with_holes_2;
     typedef std::list<Polygon_with_holes_2> Polygon_list;
+    typedef CGAL::Polygon_set_2<Kernel> Polygon_set_2;
+    typedef std::function<void(const Polygon_with_holes_2&)> Component_callback;
+    typedef std::function<void(const std::vector<std::pair<double, double>>&)> Boundary_callback;
+
+    enum OperationType {
+        UNION,
+        INTERSECTION,
+        DIFFERENCE,
+        SYMMETRIC_DIFFERENCE
+    };
 
     // Create geometric shapes
     Polygon_2 createSquare(double x, double y, double size);
@@ -26,6 +40,21 @@ public:
     
     // Boolean operations
     Polygon_list performUnion(const Polygon_2& polygon1, const Polygon_2& polygon2);
+
+    // Input validation
+    // Untrusted input (the default) is cleaned up before it reaches CGAL: repeated
+    // vertices are dropped, clockwise rings are reversed and self-intersecting rings
+    // are split into simple polygons. Trusted input must already be simple and
+    // counter-clockwise and skips all of this.
+    void setTrustedInput(bool trusted);
+    bool isTrustedInput() const;
+    Polygon_list validatePolygon(const Polygon_2& polygon);
+
+    // Result caching
+    // When a cache is set, the point-list operations below consult it before running
+    // CGAL and store what they compute. The cache is not owned.
+    void setResultCache(ResultCache* cache);
+    ResultCache* resultCache() const;
     
     // Output functions
     void printPolygonWithHoles(const Polygon_with_holes_2& poly);
@@ -51,8 +80,52 @@ public:
         const std::vector<std::pair<double, double>>& polygonA,
         const std::vector<std::pair<double, double>>& polygonB);
 
+    // Streaming variants: every component of the result is passed to onComponent as
+    // soon as it has been extracted, instead of collecting the whole result first.
+    // The components are exact, so these never go through the result cache.
+    void performUnion(
+        const std::vector<std::pair<double, double>>& polygonA,
+        const std::vector<std::pair<double, double>>& polygonB,
+        const Component_callback& onComponent);
+
+    void performIntersection(
+        const std::vector<std::pair<double, double>>& polygonA,
+        const std::vector<std::pair<double, double>>& polygonB,
+        const Component_callback& onComponent);
+
+    void performDifference(
+        const std::vector<std::pair<double, double>>& polygonA,
+        const std::vector<std::pair<double, double>>& polygonB,
+        const Component_callback& onComponent);
+
+    void performSymmetricDifference(
+        const std::vector<std::pair<double, double>>& polygonA,
+        const std::vector<std::pair<double, double>>& polygonB,
+        const Component_callback& onComponent);
+
+    // Streams the outer boundary of each result component as plain coordinates. The
+    // coordinates are rounded to double anyway, so this does use the result cache.
+    void performOperation(OperationType operation,
+        const std::vector<std::pair<double, double>>& polygonA,
+        const std::vector<std::pair<double, double>>& polygonB,
+        const Boundary_callback& onBoundary);
+
+    // Outer boundary of a result component as plain coordinates
+    std::vector<std::pair<double, double>> convertFromPolygon(const Polygon_with_holes_2& polygon);
+
 private:
     // Helper methods to convert between CGAL and standard representations
     Polygon_2 convertToPolygon(const std::vector<std::pair<double, double>>& points);
-    std::vector<std::pair<double, double>> convertFromPolygon(const Polygon_with_holes_2& polygon);
+
+    // Convert and (unless trusted) validate an input polygon
+    Polygon_list prepareInput(const std::vector<std::pair<double, double>>& points);
+    Polygon_list computeOperation(OperationType operation, const Polygon_list& polygonsA, const Polygon_list& polygonsB);
+    void computeOperation(OperationType operation, const Polygon_list& polygonsA, const Polygon_list& polygonsB,
+        const Component_callback& onComponent);
+    Polygon_list runOperation(OperationType operation,
+        const std::vector<std::pair<double, double>>& polygonA,
+        const std::vector<std::pair<double, double>>& polygonB);
+
+    bool trustedInput;
+    ResultCache* cache;
 };
\ No newline at end of file
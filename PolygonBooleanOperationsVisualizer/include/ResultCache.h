@@ -0,0 +1,85 @@
+#pragma once
+
+#include "BooleanOperations.h"
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Content-addressed cache of Boolean operation results.
+//
+// Entries are keyed by the operation and the normalized input coordinates, so the
+// same shapes hit the cache regardless of starting vertex, orientation or repeated
+// vertices. Recently used entries are kept in memory (LRU); if a directory is set,
+// every entry is also written there in a compact binary form so it survives restarts.
+// The directory may be shared between processes; once it grows past the disk limit,
+// the least recently used files are deleted.
+class ResultCache {
+public:
+    typedef std::vector<std::pair<double, double>> Ring;
+
+    struct Component {
+        Ring outer;
+        std::vector<Ring> holes;
+    };
+    typedef std::vector<Component> Result;
+
+    struct Statistics {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t diskHits;
+        std::size_t evictions;
+    };
+
+    explicit ResultCache(std::size_t capacity = 64, const std::string& directory = std::string(),
+        std::uintmax_t diskLimit = 256 * 1024 * 1024);
+    ~ResultCache();
+
+    // Build the lookup key for an operation on two input polygons. Trusted input skips
+    // repair, so its result depends on the exact rings: those are keyed verbatim and
+    // never share an entry with untrusted input.
+    static std::string makeKey(BooleanOperations::OperationType operation,
+        const Ring& polygonA, const Ring& polygonB, bool trustedInput = false);
+
+    // Look up a result in memory, then on disk. Returns false on a miss.
+    bool lookup(const std::string& key, Result& result);
+    void store(const std::string& key, const Result& result);
+
+    // Drop all in-memory entries (files on disk are kept)
+    void clear();
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+    const std::string& directory() const;
+    std::uintmax_t diskLimit() const;
+    Statistics statistics() const;
+
+private:
+    struct Entry {
+        std::string key;
+        Result result;
+    };
+    typedef std::list<Entry> Entry_list;
+
+    static Ring normalizeRing(const Ring& ring);
+    static std::uint64_t hashBytes(const std::string& bytes);
+    std::string pathForKey(const std::string& key) const;
+
+    void insertInMemory(const std::string& key, const Result& result);
+    bool readFromDisk(const std::string& key, Result& result) const;
+    void writeToDisk(const std::string& key, const Result& result);
+    void pruneDisk();
+
+    std::size_t maxEntries;
+    std::string cacheDirectory;
+    std::uintmax_t maxDiskBytes;  // 0 means unlimited
+    std::uintmax_t estimatedDiskBytes;  // Directory size at the last scan plus our writes since
+    std::size_t writesSinceScan;
+    bool diskScanned;
+    Entry_list entries;  // Most recently used first
+    std::unordered_map<std::string, Entry_list::iterator> index;
+    Statistics stats;
+};
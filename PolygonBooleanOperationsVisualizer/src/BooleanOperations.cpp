@@ -1,10 +1,187 @@
 #include "../include/BooleanOperations.h"
+#include "../include/ResultCache.h"
 #include <iostream>
 #include <CGAL/IO/io.h>
 #include <CGAL/Boolean_set_operations_2.h>
+#include <CGAL/version.h>
+#if CGAL_VERSION_NR >= CGAL_VERSION_NUMBER(6, 0, 0)
+#include <CGAL/Polygon_repair/repair.h>
+#else
+#include <CGAL/Arr_segment_traits_2.h>
+#include <CGAL/Arrangement_with_history_2.h>
+#include <unordered_map>
+#endif
+#include <boost/iterator/function_output_iterator.hpp>
 
-BooleanOperations::BooleanOperations() {
-    // Empty constructor
+namespace {
+
+ResultCache::Ring toRing(const BooleanOperations::Polygon_2& polygon) {
+    ResultCache::Ring ring;
+    ring.reserve(polygon.size());
+    for (auto vertex_it = polygon.vertices_begin(); vertex_it != polygon.vertices_end(); ++vertex_it) {
+        ring.push_back(std::make_pair(CGAL::to_double(vertex_it->x()), CGAL::to_double(vertex_it->y())));
+    }
+    return ring;
+}
+
+BooleanOperations::Polygon_2 fromRing(const ResultCache::Ring& ring) {
+    BooleanOperations::Polygon_2 polygon;
+    for (const auto& point : ring) {
+        polygon.push_back(BooleanOperations::Point_2(point.first, point.second));
+    }
+    return polygon;
+}
+
+ResultCache::Result toCachedResult(const BooleanOperations::Polygon_list& polygons) {
+    ResultCache::Result result;
+    result.reserve(polygons.size());
+    for (const auto& poly : polygons) {
+        ResultCache::Component component;
+        component.outer = toRing(poly.outer_boundary());
+        for (auto hole_it = poly.holes_begin(); hole_it != poly.holes_end(); ++hole_it) {
+            component.holes.push_back(toRing(*hole_it));
+        }
+        result.push_back(component);
+    }
+    return result;
+}
+
+BooleanOperations::Polygon_list fromCachedResult(const ResultCache::Result& cached) {
+    BooleanOperations::Polygon_list result;
+    for (const auto& component : cached) {
+        std::vector<BooleanOperations::Polygon_2> holes;
+        for (const auto& hole : component.holes) {
+            holes.push_back(fromRing(hole));
+        }
+        result.push_back(BooleanOperations::Polygon_with_holes_2(fromRing(component.outer), holes.begin(), holes.end()));
+    }
+    return result;
+}
+
+#if CGAL_VERSION_NR < CGAL_VERSION_NUMBER(6, 0, 0)
+
+typedef CGAL::Arr_segment_traits_2<BooleanOperations::Kernel> Arr_traits;
+typedef CGAL::Arrangement_with_history_2<Arr_traits> Arrangement;
+
+// Walk one boundary cycle of a face and split it into simple loops. Antenna edges
+// (same face on both sides) are skipped and the walk is cut wherever it revisits a vertex.
+void appendLoops(Arrangement::Ccb_halfedge_const_circulator ccb, std::vector<BooleanOperations::Polygon_2>& loops) {
+    std::vector<Arrangement::Vertex_const_handle> path;
+    std::unordered_map<const void*, std::size_t> positions;
+    
+    auto closeLoop = [&loops, &path](std::size_t from) {
+        if (path.size() - from >= 3) {
+            BooleanOperations::Polygon_2 loop;
+            for (std::size_t i = from; i < path.size(); ++i) {
+                loop.push_back(path[i]->point());
+            }
+            loops.push_back(loop);
+        }
+    };
+    
+    Arrangement::Ccb_halfedge_const_circulator curr = ccb;
+    do {
+        if (curr->twin()->face() == curr->face()) {
+            continue;
+        }
+        Arrangement::Vertex_const_handle vertex = curr->source();
+        auto found = positions.find(&*vertex);
+        if (found == positions.end()) {
+            positions[&*vertex] = path.size();
+            path.push_back(vertex);
+            continue;
+        }
+        closeLoop(found->second);
+        for (std::size_t i = found->second + 1; i < path.size(); ++i) {
+            positions.erase(&*path[i]);
+        }
+        path.resize(found->second + 1);
+    } while (++curr != ccb);
+    
+    closeLoop(0);
+}
+
+// Even-odd repair for CGAL versions without Polygon_repair. The ring's segments are
+// overlaid in an arrangement that remembers how many input segments cover each edge;
+// crossing an edge covered an odd number of times flips inside/outside.
+BooleanOperations::Polygon_list repairEvenOdd(const std::vector<BooleanOperations::Point_2>& points) {
+    std::vector<Arr_traits::Curve_2> segments;
+    segments.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        segments.push_back(Arr_traits::Curve_2(points[i], points[(i + 1) % points.size()]));
+    }
+    
+    Arrangement arrangement;
+    CGAL::insert(arrangement, segments.begin(), segments.end());
+    
+    // Assign parities by walking outwards from the unbounded face
+    std::unordered_map<const void*, bool> inside;
+    std::vector<Arrangement::Face_const_handle> pending;
+    inside[&*arrangement.unbounded_face()] = false;
+    pending.push_back(arrangement.unbounded_face());
+    
+    auto visitCcb = [&](Arrangement::Face_const_handle face, Arrangement::Ccb_halfedge_const_circulator ccb) {
+        Arrangement::Ccb_halfedge_const_circulator curr = ccb;
+        do {
+            Arrangement::Face_const_handle neighbour = curr->twin()->face();
+            if (inside.find(&*neighbour) == inside.end()) {
+                bool flips = arrangement.number_of_originating_curves(Arrangement::Halfedge_const_handle(curr)) % 2 == 1;
+                inside[&*neighbour] = inside[&*face] != flips;
+                pending.push_back(neighbour);
+            }
+        } while (++curr != ccb);
+    };
+    
+    std::vector<BooleanOperations::Polygon_with_holes_2> faces;
+    while (!pending.empty()) {
+        Arrangement::Face_const_handle face = pending.back();
+        pending.pop_back();
+        
+        if (face->has_outer_ccb()) {
+            visitCcb(face, face->outer_ccb());
+        }
+        for (auto ccb_it = face->inner_ccbs_begin(); ccb_it != face->inner_ccbs_end(); ++ccb_it) {
+            visitCcb(face, *ccb_it);
+        }
+        
+        if (face->is_unbounded() || !inside[&*face]) {
+            continue;
+        }
+        
+        std::vector<BooleanOperations::Polygon_2> loops;
+        appendLoops(face->outer_ccb(), loops);
+        for (auto ccb_it = face->inner_ccbs_begin(); ccb_it != face->inner_ccbs_end(); ++ccb_it) {
+            appendLoops(*ccb_it, loops);
+        }
+        
+        // A face is connected, so exactly one loop runs counter-clockwise around it;
+        // the clockwise loops are its holes and may touch it only at vertices
+        BooleanOperations::Polygon_2 outer;
+        std::vector<BooleanOperations::Polygon_2> holes;
+        for (const auto& loop : loops) {
+            if (loop.is_counterclockwise_oriented()) {
+                outer = loop;
+            } else {
+                holes.push_back(loop);
+            }
+        }
+        faces.push_back(BooleanOperations::Polygon_with_holes_2(outer, holes.begin(), holes.end()));
+    }
+    
+    // Merge the interior-disjoint faces in a single aggregated overlay
+    BooleanOperations::Polygon_set_2 region;
+    region.join(faces.begin(), faces.end());
+    
+    BooleanOperations::Polygon_list result;
+    region.polygons_with_holes(std::back_inserter(result));
+    return result;
+}
+
+#endif
+
+} // namespace
+
+BooleanOperations::BooleanOperations() : trustedInput(false), cache(nullptr) {
 }
 
 BooleanOperations::~BooleanOperations() {
@@ -45,6 +222,66 @@ BooleanOperations::Polygon_list BooleanOperations::performUnion(const Polygon_2&
     return result;
 }
 
+void BooleanOperations::setTrustedInput(bool trusted) {
+    trustedInput = trusted;
+}
+
+bool BooleanOperations::isTrustedInput() const {
+    return trustedInput;
+}
+
+void BooleanOperations::setResultCache(ResultCache* resultCache) {
+    cache = resultCache;
+}
+
+ResultCache* BooleanOperations::resultCache() const {
+    return cache;
+}
+
+// Repair a polygon into a list of simple, counter-clockwise polygons with holes
+BooleanOperations::Polygon_list BooleanOperations::validatePolygon(const Polygon_2& polygon) {
+    Polygon_list result;
+    
+    // Drop repeated consecutive vertices, including an explicit closing vertex
+    std::vector<Point_2> points;
+    points.reserve(polygon.size());
+    for (auto vertex_it = polygon.vertices_begin(); vertex_it != polygon.vertices_end(); ++vertex_it) {
+        if (points.empty() || points.back() != *vertex_it) {
+            points.push_back(*vertex_it);
+        }
+    }
+    while (points.size() > 1 && points.back() == points.front()) {
+        points.pop_back();
+    }
+    
+    // Fewer than three distinct vertices enclose no area
+    if (points.size() < 3) {
+        return result;
+    }
+    
+    Polygon_2 cleaned(points.begin(), points.end());
+    
+    // is_simple() runs CGAL's sweep-line segment intersection test
+    if (cleaned.is_simple()) {
+        if (cleaned.is_clockwise_oriented()) {
+            cleaned.reverse_orientation();
+        }
+        result.push_back(Polygon_with_holes_2(cleaned));
+        return result;
+    }
+    
+    // Split a self-intersecting ring into its even-odd interior
+#if CGAL_VERSION_NR >= CGAL_VERSION_NUMBER(6, 0, 0)
+    auto repaired = CGAL::Polygon_repair::repair(cleaned, CGAL::Polygon_repair::Even_odd_rule());
+    for (const auto& component : repaired.polygons_with_holes()) {
+        result.push_back(component);
+    }
+    return result;
+#else
+    return repairEvenOdd(points);
+#endif
+}
+
 // Convert vector of points to CGAL Polygon
 BooleanOperations::Polygon_2 BooleanOperations::convertToPolygon(const std::vector<std::pair<double, double>>& points) {
     Polygon_2 polygon;
@@ -70,16 +307,83 @@ std::vector<std::pair<double, double>> BooleanOperations::convertFromPolygon(con
     return result;
 }
 
+// Convert and validate an input polygon
+BooleanOperations::Polygon_list BooleanOperations::prepareInput(const std::vector<std::pair<double, double>>& points) {
+    Polygon_2 polygon = convertToPolygon(points);
+    
+    if (trustedInput) {
+        Polygon_list result;
+        result.push_back(Polygon_with_holes_2(polygon));
+        return result;
+    }
+    
+    return validatePolygon(polygon);
+}
+
+// Run a Boolean operation on two validated inputs
+BooleanOperations::Polygon_list BooleanOperations::computeOperation(
+    OperationType operation, const Polygon_list& polygonsA, const Polygon_list& polygonsB) {
+    
+    Polygon_list result;
+    computeOperation(operation, polygonsA, polygonsB,
+        [&result](const Polygon_with_holes_2& poly) { result.push_back(poly); });
+    return result;
+}
+
+// Run a Boolean operation, handing each result component to the callback as it is extracted
+void BooleanOperations::computeOperation(OperationType operation, const Polygon_list& polygonsA,
+    const Polygon_list& polygonsB, const Component_callback& onComponent) {
+    
+    Polygon_set_2 setA;
+    Polygon_set_2 setB;
+    setA.join(polygonsA.begin(), polygonsA.end());
+    setB.join(polygonsB.begin(), polygonsB.end());
+    
+    switch (operation) {
+        case UNION:
+            setA.join(setB);
+            break;
+        case INTERSECTION:
+            setA.intersection(setB);
+            break;
+        case DIFFERENCE:
+            setA.difference(setB);
+            break;
+        case SYMMETRIC_DIFFERENCE:
+            setA.symmetric_difference(setB);
+            break;
+    }
+    
+    setA.polygons_with_holes(boost::make_function_output_iterator(onComponent));
+}
+
+// Run an operation on point lists, going through the result cache if one is set
+BooleanOperations::Polygon_list BooleanOperations::runOperation(OperationType operation,
+    const std::vector<std::pair<double, double>>& polygonA,
+    const std::vector<std::pair<double, double>>& polygonB) {
+    
+    if (!cache) {
+        return computeOperation(operation, prepareInput(polygonA), prepareInput(polygonB));
+    }
+    
+    std::string key = ResultCache::makeKey(operation, polygonA, polygonB, trustedInput);
+    ResultCache::Result cached;
+    if (cache->lookup(key, cached)) {
+        return fromCachedResult(cached);
+    }
+    
+    Polygon_list result = computeOperation(operation, prepareInput(polygonA), prepareInput(polygonB));
+    cache->store(key, toCachedResult(result));
+    return result;
+}
+
 // Interface methods for Qt application
 
 std::vector<std::pair<double, double>> BooleanOperations::performUnion(
     const std::vector<std::pair<double, double>>& polygonA,
     const std::vector<std::pair<double, double>>& polygonB) {
     
-    Polygon_2 poly1 = convertToPolygon(polygonA);
-    Polygon_2 poly2 = convertToPolygon(polygonB);
-    
-    Polygon_list result = performUnion(poly1, poly2);
+    Polygon_list result = runOperation(UNION, polygonA, polygonB);
     
     // If result is empty, return empty vector
     if (result.empty()) {
@@ -94,18 +398,14 @@ std::vector<std::pair<double, double>> BooleanOperations::performIntersection(
     const std::vector<std::pair<double, double>>& polygonA,
     const std::vector<std::pair<double, double>>& polygonB) {
     
-    Polygon_2 poly1 = convertToPolygon(polygonA);
-    Polygon_2 poly2 = convertToPolygon(polygonB);
-    
-    Polygon_list result;
-    CGAL::intersection(poly1, poly2, std::back_inserter(result));
+    Polygon_list result = runOperation(INTERSECTION, polygonA, polygonB);
     
     // If result is empty, return empty vector
     if (result.empty()) {
         return std::vector<std::pair<double, double>>();
     }
     
-    // Return the first polygon's boundary
+    // Return the first polygon's boundary (simplification)
     return convertFromPolygon(result.front());
 }
 
@@ -113,18 +413,14 @@ std::vector<std::pair<double, double>> BooleanOperations::performDifference(
     const std::vector<std::pair<double, double>>& polygonA,
     const std::vector<std::pair<double, double>>& polygonB) {
     
-    Polygon_2 poly1 = convertToPolygon(polygonA);
-    Polygon_2 poly2 = convertToPolygon(polygonB);
-    
-    Polygon_list result;
-    CGAL::difference(poly1, poly2, std::back_inserter(result));
+    Polygon_list result = runOperation(DIFFERENCE, polygonA, polygonB);
     
     // If result is empty, return empty vector
     if (result.empty()) {
         return std::vector<std::pair<double, double>>();
     }
     
-    // Return the first polygon's boundary
+    // Return the first polygon's boundary (simplification)
     return convertFromPolygon(result.front());
 }
 
@@ -132,21 +428,81 @@ std::vector<std::pair<double, double>> BooleanOperations::performSymmetricDiffer
     const std::vector<std::pair<double, double>>& polygonA,
     const std::vector<std::pair<double, double>>& polygonB) {
     
-    Polygon_2 poly1 = convertToPolygon(polygonA);
-    Polygon_2 poly2 = convertToPolygon(polygonB);
-    
-    Polygon_list result;
-    CGAL::symmetric_difference(poly1, poly2, std::back_inserter(result));
+    Polygon_list result = runOperation(SYMMETRIC_DIFFERENCE, polygonA, polygonB);
     
     // If result is empty, return empty vector
     if (result.empty()) {
         return std::vector<std::pair<double, double>>();
     }
     
-    // Return the first polygon's boundary
+    // Return the first polygon's boundary (simplification)
     return convertFromPolygon(result.front());
 }
 
+// Streaming interface methods
+
+void BooleanOperations::performUnion(
+    const std::vector<std::pair<double, double>>& polygonA,
+    const std::vector<std::pair<double, double>>& polygonB,
+    const Component_callback& onComponent) {
+    
+    computeOperation(UNION, prepareInput(polygonA), prepareInput(polygonB), onComponent);
+}
+
+void BooleanOperations::performIntersection(
+    const std::vector<std::pair<double, double>>& polygonA,
+    const std::vector<std::pair<double, double>>& polygonB,
+    const Component_callback& onComponent) {
+    
+    computeOperation(INTERSECTION, prepareInput(polygonA), prepareInput(polygonB), onComponent);
+}
+
+void BooleanOperations::performDifference(
+    const std::vector<std::pair<double, double>>& polygonA,
+    const std::vector<std::pair<double, double>>& polygonB,
+    const Component_callback& onComponent) {
+    
+    computeOperation(DIFFERENCE, prepareInput(polygonA), prepareInput(polygonB), onComponent);
+}
+
+void BooleanOperations::performSymmetricDifference(
+    const std::vector<std::pair<double, double>>& polygonA,
+    const std::vector<std::pair<double, double>>& polygonB,
+    const Component_callback& onComponent) {
+    
+    computeOperation(SYMMETRIC_DIFFERENCE, prepareInput(polygonA), prepareInput(polygonB), onComponent);
+}
+
+void BooleanOperations::performOperation(OperationType operation,
+    const std::vector<std::pair<double, double>>& polygonA,
+    const std::vector<std::pair<double, double>>& polygonB,
+    const Boundary_callback& onBoundary) {
+    
+    if (!cache) {
+        computeOperation(operation, prepareInput(polygonA), prepareInput(polygonB),
+            [this, &onBoundary](const Polygon_with_holes_2& poly) { onBoundary(convertFromPolygon(poly)); });
+        return;
+    }
+    
+    std::string key = ResultCache::makeKey(operation, polygonA, polygonB, trustedInput);
+    ResultCache::Result cached;
+    if (cache->lookup(key, cached)) {
+        for (const auto& component : cached) {
+            onBoundary(component.outer);
+        }
+        return;
+    }
+    
+    // Forward boundaries as they arrive and keep the components for the cache
+    Polygon_list result;
+    computeOperation(operation, prepareInput(polygonA), prepareInput(polygonB),
+        [this, &result, &onBoundary](const Polygon_with_holes_2& poly) {
+            onBoundary(convertFromPolygon(poly));
+            result.push_back(poly);
+        });
+    cache->store(key, toCachedResult(result));
+}
+
 // Print a polygon with holes
 void BooleanOperations::printPolygonWithHoles(const Polygon_with_holes_2& poly) {
     std::cout << "Outer boundary:" << std::endl;
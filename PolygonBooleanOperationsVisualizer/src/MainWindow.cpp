@@ -4,12 +4,15 @@
 #include <QMessageBox>
 #include <QColorDialog>
 #include <QInputDialog>
+#include <QCoreApplication>
+#include <QElapsedTimer>
 
 // Include the BooleanOperations header
 #include "../include/BooleanOperations.h"
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), currentDrawMode(SELECT), currentOperation(UNION), isDrawing(false)
+    : QMainWindow(parent), currentDrawMode(SELECT), currentOperation(UNION), isDrawing(false),
+      resultCache(64, qgetenv("POLYGON_RESULT_CACHE").toStdString())  // Optional on-disk cache directory
 {
     setupUI();
     setupActions();
@@ -212,45 +215,75 @@ void MainWindow::performOperation()
         pointsB.push_back(std::make_pair(point.x(), point.y()));
     }
     
-    // Call the BooleanOperations class to perform the selected operation
-    std::vector<std::pair<double, double>> resultPoints;
+    // Redraw the inputs and add each result component as soon as it is produced
+    scene->clear();
+    drawPolygon(polygonA, Qt::blue);
+    drawPolygon(polygonB, Qt::green);
+    resultPolygon = QPolygonF();
+    int componentCount = 0;
+    
+    // Repainting after every component would make rendering quadratic in the number of
+    // components, so the view is only refreshed every few tens of milliseconds
+    QElapsedTimer repaintTimer;
+    repaintTimer.start();
     
     try {
         BooleanOperations operations;
+        operations.setResultCache(&resultCache);
+        
+        BooleanOperations::Boundary_callback drawComponent =
+            [this, &componentCount, &repaintTimer](const std::vector<std::pair<double, double>>& boundary) {
+                QPolygonF component;
+                for (const auto& point : boundary) {
+                    component << QPointF(point.first, point.second);
+                }
+                
+                // The first component is the one saved by saveResult()
+                if (componentCount++ == 0) {
+                    resultPolygon = component;
+                }
+                
+                drawPolygon(component, Qt::red);
+                if (repaintTimer.elapsed() >= 30) {
+                    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+                    repaintTimer.restart();
+                }
+            };
         
+        BooleanOperations::OperationType operation = BooleanOperations::UNION;
         switch (currentOperation) {
             case UNION:
-                resultPoints = operations.performUnion(pointsA, pointsB);
+                operation = BooleanOperations::UNION;
                 break;
             case INTERSECTION:
-                resultPoints = operations.performIntersection(pointsA, pointsB);
+                operation = BooleanOperations::INTERSECTION;
                 break;
             case DIFFERENCE:
-                resultPoints = operations.performDifference(pointsA, pointsB);
+                operation = BooleanOperations::DIFFERENCE;
                 break;
             case SYMMETRIC_DIFFERENCE:
-                resultPoints = operations.performSymmetricDifference(pointsA, pointsB);
+                operation = BooleanOperations::SYMMETRIC_DIFFERENCE;
                 break;
         }
+        
+        operations.performOperation(operation, pointsA, pointsB, drawComponent);
     }
     catch (const std::exception& e) {
+        // Drop the partial result so it is neither shown nor saved
+        resultPolygon = QPolygonF();
+        scene->clear();
+        drawPolygon(polygonA, Qt::blue);
+        drawPolygon(polygonB, Qt::green);
         QMessageBox::critical(this, "Error", QString("Error performing operation: %1").arg(e.what()));
         return;
     }
     
-    // Convert result back to QPolygonF
-    resultPolygon = QPolygonF();
-    for (const auto& point : resultPoints) {
-        resultPolygon << QPointF(point.first, point.second);
-    }
-    
-    // Display result
-    scene->clear();
-    drawPolygon(polygonA, Qt::blue);
-    drawPolygon(polygonB, Qt::green);
-    drawPolygon(resultPolygon, Qt::red);
+    // Show any components added since the last throttled repaint
+    view->viewport()->update();
     
-    statusBar->showMessage("Operation performed successfully");
+    ResultCache::Statistics stats = resultCache.statistics();
+    statusBar->showMessage(QString("Operation performed successfully: %1 component(s) (cache: %2 hits, %3 misses)")
+        .arg(componentCount).arg(stats.hits).arg(stats.misses));
 }
 
 void MainWindow::saveResult()
@@ -17,6 +17,7 @@
 #include <QMouseEvent>  // Add this for mouse event handling
 #include "MainWindow.h"
 #include "../include/BooleanOperations.h"
+#include "../include/ResultCache.h"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -75,4 +76,5 @@ private:
     QPolygonF resultPolygon;
     QVector<QPointF> currentPoints;
     bool isDrawing;
+    ResultCache resultCache;
 };
\ No newline at end of file
@@ -0,0 +1,465 @@
+#include "../include/ResultCache.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <iterator>
+#include <exception>
+#include <atomic>
+#include <random>
+#include <chrono>
+
+namespace {
+
+// On-disk entry layout (native byte order):
+//   magic, version, checksum of the payload, then the payload:
+//   key length, key bytes, component count,
+//   then per component: hole count, outer ring, holes.
+//   A ring is a vertex count followed by x/y doubles.
+const std::uint32_t CACHE_FILE_MAGIC = 0x43524250;  // "PBRC"
+const std::uint32_t CACHE_FILE_VERSION = 2;
+const std::size_t CACHE_HEADER_SIZE = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+// The directory is rescanned after this many writes even if the running size estimate
+// is under the limit, to account for other processes sharing it
+const std::size_t DISK_RESCAN_INTERVAL = 64;
+
+// Temporary files this old belong to a writer that died before renaming them
+const std::chrono::hours STALE_TEMP_AGE(1);
+
+template <typename T>
+void appendValue(std::string& bytes, T value)
+{
+    char buffer[sizeof(T)];
+    std::memcpy(buffer, &value, sizeof(T));
+    bytes.append(buffer, sizeof(T));
+}
+
+void appendRing(std::string& bytes, const ResultCache::Ring& ring)
+{
+    appendValue<std::uint32_t>(bytes, static_cast<std::uint32_t>(ring.size()));
+    for (const auto& point : ring) {
+        appendValue(bytes, point.first);
+        appendValue(bytes, point.second);
+    }
+}
+
+// Bounds-checked reads from an in-memory file
+class ByteReader {
+public:
+    ByteReader(const std::string& bytes, std::size_t offset) : data(bytes), position(offset) {}
+
+    template <typename T>
+    bool read(T& value)
+    {
+        if (remaining() < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    bool readBytes(std::size_t count, std::string& value)
+    {
+        if (remaining() < count) {
+            return false;
+        }
+        value.assign(data, position, count);
+        position += count;
+        return true;
+    }
+
+    std::size_t remaining() const
+    {
+        return data.size() - position;
+    }
+
+private:
+    const std::string& data;
+    std::size_t position;
+};
+
+// Suffix that keeps temporary files of concurrent writers apart
+std::string uniqueTempSuffix()
+{
+    static const std::uint64_t processTag =
+        (static_cast<std::uint64_t>(std::random_device()()) << 32) ^ std::random_device()();
+    static std::atomic<std::uint64_t> counter(0);
+
+    char suffix[64];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx.%llu.tmp",
+        static_cast<unsigned long long>(processTag), static_cast<unsigned long long>(counter++));
+    return suffix;
+}
+
+bool readRing(ByteReader& reader, ResultCache::Ring& ring)
+{
+    std::uint32_t count;
+    if (!reader.read(count) || count > reader.remaining() / (2 * sizeof(double))) {
+        return false;
+    }
+    ring.resize(count);
+    for (auto& point : ring) {
+        if (!reader.read(point.first) || !reader.read(point.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+ResultCache::ResultCache(std::size_t capacity, const std::string& directory, std::uintmax_t diskLimit)
+    : maxEntries(capacity), cacheDirectory(directory), maxDiskBytes(diskLimit),
+      estimatedDiskBytes(0), writesSinceScan(0), diskScanned(false), stats{0, 0, 0, 0}
+{
+    if (!cacheDirectory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(cacheDirectory, error);
+    }
+}
+
+ResultCache::~ResultCache()
+{
+}
+
+// Drop repeated vertices, orient counter-clockwise and start at the smallest vertex
+ResultCache::Ring ResultCache::normalizeRing(const Ring& ring)
+{
+    Ring normalized;
+    normalized.reserve(ring.size());
+    for (const auto& point : ring) {
+        // Adding 0.0 folds -0.0 into 0.0 so both hash the same
+        std::pair<double, double> vertex(point.first + 0.0, point.second + 0.0);
+        if (normalized.empty() || normalized.back() != vertex) {
+            normalized.push_back(vertex);
+        }
+    }
+    while (normalized.size() > 1 && normalized.back() == normalized.front()) {
+        normalized.pop_back();
+    }
+    if (normalized.size() < 3) {
+        return normalized;
+    }
+
+    double twiceArea = 0.0;
+    for (std::size_t i = 0; i < normalized.size(); ++i) {
+        const auto& p = normalized[i];
+        const auto& q = normalized[(i + 1) % normalized.size()];
+        twiceArea += p.first * q.second - q.first * p.second;
+    }
+    if (twiceArea < 0.0) {
+        std::reverse(normalized.begin(), normalized.end());
+    }
+
+    std::rotate(normalized.begin(), std::min_element(normalized.begin(), normalized.end()), normalized.end());
+    return normalized;
+}
+
+std::string ResultCache::makeKey(BooleanOperations::OperationType operation,
+    const Ring& polygonA, const Ring& polygonB, bool trustedInput)
+{
+    Ring ringA = trustedInput ? polygonA : normalizeRing(polygonA);
+    Ring ringB = trustedInput ? polygonB : normalizeRing(polygonB);
+
+    std::string key;
+    key.reserve(2 + 2 * sizeof(std::uint32_t) + (ringA.size() + ringB.size()) * 2 * sizeof(double));
+    key.push_back(static_cast<char>(operation));
+    key.push_back(trustedInput ? 1 : 0);
+    for (const Ring* ring : { &ringA, &ringB }) {
+        appendValue<std::uint32_t>(key, static_cast<std::uint32_t>(ring->size()));
+        for (const auto& point : *ring) {
+            appendValue(key, point.first);
+            appendValue(key, point.second);
+        }
+    }
+    return key;
+}
+
+// 64-bit FNV-1a, used to name files on disk and to checksum their contents
+std::uint64_t ResultCache::hashBytes(const std::string& bytes)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char byte : bytes) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string ResultCache::pathForKey(const std::string& key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hashBytes(key)));
+    return (std::filesystem::path(cacheDirectory) / name).string();
+}
+
+bool ResultCache::lookup(const std::string& key, Result& result)
+{
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Move to the front of the LRU list
+        entries.splice(entries.begin(), entries, it->second);
+        result = it->second->result;
+        ++stats.hits;
+        return true;
+    }
+
+    bool loaded = false;
+    if (!cacheDirectory.empty()) {
+        // An unreadable entry is only a miss; the caller recomputes and overwrites it
+        try {
+            loaded = readFromDisk(key, result);
+        } catch (const std::exception&) {
+            loaded = false;
+        }
+    }
+    if (loaded) {
+        insertInMemory(key, result);
+        ++stats.hits;
+        ++stats.diskHits;
+        return true;
+    }
+
+    ++stats.misses;
+    return false;
+}
+
+void ResultCache::store(const std::string& key, const Result& result)
+{
+    insertInMemory(key, result);
+    if (!cacheDirectory.empty()) {
+        writeToDisk(key, result);
+    }
+}
+
+void ResultCache::insertInMemory(const std::string& key, const Result& result)
+{
+    if (maxEntries == 0) {
+        return;
+    }
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->result = result;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    entries.push_front(Entry{ key, result });
+    index[key] = entries.begin();
+
+    while (entries.size() > maxEntries) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+        ++stats.evictions;
+    }
+}
+
+bool ResultCache::readFromDisk(const std::string& key, Result& result) const
+{
+    std::string path = pathForKey(key);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    ByteReader header(bytes, 0);
+    std::uint32_t magic, version;
+    std::uint64_t checksum;
+    if (!header.read(magic) || !header.read(version) || !header.read(checksum)) {
+        return false;
+    }
+    if (magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION) {
+        return false;
+    }
+    if (checksum != hashBytes(bytes.substr(CACHE_HEADER_SIZE))) {
+        return false;
+    }
+
+    // The file name is only a hash; compare the full key to rule out collisions
+    ByteReader reader(bytes, CACHE_HEADER_SIZE);
+    std::uint32_t keyLength;
+    std::string storedKey;
+    if (!reader.read(keyLength) || !reader.readBytes(keyLength, storedKey) || storedKey != key) {
+        return false;
+    }
+
+    // Every component needs at least a hole count and a vertex count
+    std::uint32_t componentCount;
+    if (!reader.read(componentCount) || componentCount > reader.remaining() / (2 * sizeof(std::uint32_t))) {
+        return false;
+    }
+
+    Result loaded(componentCount);
+    for (auto& component : loaded) {
+        std::uint32_t holeCount;
+        if (!reader.read(holeCount) || !readRing(reader, component.outer)) {
+            return false;
+        }
+        if (holeCount > reader.remaining() / sizeof(std::uint32_t)) {
+            return false;
+        }
+        component.holes.resize(holeCount);
+        for (auto& hole : component.holes) {
+            if (!readRing(reader, hole)) {
+                return false;
+            }
+        }
+    }
+    if (reader.remaining() != 0) {
+        return false;
+    }
+
+    // Mark the entry as recently used so pruning keeps it
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+    result.swap(loaded);
+    return true;
+}
+
+void ResultCache::writeToDisk(const std::string& key, const Result& result)
+{
+    std::string payload;
+    appendValue<std::uint32_t>(payload, static_cast<std::uint32_t>(key.size()));
+    payload.append(key);
+    appendValue<std::uint32_t>(payload, static_cast<std::uint32_t>(result.size()));
+    for (const auto& component : result) {
+        appendValue<std::uint32_t>(payload, static_cast<std::uint32_t>(component.holes.size()));
+        appendRing(payload, component.outer);
+        for (const auto& hole : component.holes) {
+            appendRing(payload, hole);
+        }
+    }
+
+    std::string header;
+    appendValue(header, CACHE_FILE_MAGIC);
+    appendValue(header, CACHE_FILE_VERSION);
+    appendValue(header, hashBytes(payload));
+
+    // Write to a temporary file first so readers never see a partial entry
+    std::string path = pathForKey(key);
+    std::string tempPath = path + uniqueTempSuffix();
+    bool written = false;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return;
+        }
+        out.write(header.data(), header.size());
+        out.write(payload.data(), payload.size());
+        out.close();
+        written = static_cast<bool>(out);
+    }
+
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(tempPath, path, error);
+    }
+    if (!written || error) {
+        std::filesystem::remove(tempPath, error);
+        return;
+    }
+
+    // Only list the directory when the running estimate says it may be over the limit
+    estimatedDiskBytes += header.size() + payload.size();
+    ++writesSinceScan;
+    if (!diskScanned || writesSinceScan >= DISK_RESCAN_INTERVAL ||
+        (maxDiskBytes != 0 && estimatedDiskBytes > maxDiskBytes)) {
+        pruneDisk();
+    }
+}
+
+// Remove stale temporary files, then delete the least recently used entries until the
+// directory fits the disk limit
+void ResultCache::pruneDisk()
+{
+    struct DiskEntry {
+        std::filesystem::file_time_type lastUsed;
+        std::uintmax_t size;
+        std::filesystem::path path;
+    };
+    std::vector<DiskEntry> files;
+    std::uintmax_t totalSize = 0;
+
+    auto now = std::filesystem::file_time_type::clock::now();
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(cacheDirectory, error), end; !error && it != end; it.increment(error)) {
+        std::filesystem::path extension = it->path().extension();
+        if (extension != ".bin" && extension != ".tmp") {
+            continue;
+        }
+        std::error_code entryError;
+        DiskEntry entry{ it->last_write_time(entryError), it->file_size(entryError), it->path() };
+        if (entryError) {
+            continue;
+        }
+        if (extension == ".tmp") {
+            // A recent temporary file may still be in use: count it but leave it alone
+            if (now - entry.lastUsed > STALE_TEMP_AGE && std::filesystem::remove(entry.path, entryError)) {
+                continue;
+            }
+            totalSize += entry.size;
+            continue;
+        }
+        totalSize += entry.size;
+        files.push_back(entry);
+    }
+
+    diskScanned = true;
+    writesSinceScan = 0;
+    estimatedDiskBytes = totalSize;
+    if (maxDiskBytes == 0 || totalSize <= maxDiskBytes) {
+        return;
+    }
+
+    std::sort(files.begin(), files.end(), [](const DiskEntry& a, const DiskEntry& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+    for (const auto& file : files) {
+        if (totalSize <= maxDiskBytes) {
+            break;
+        }
+        // Another process may have removed it already
+        if (std::filesystem::remove(file.path, error) || !std::filesystem::exists(file.path, error)) {
+            totalSize -= file.size;
+        }
+    }
+    estimatedDiskBytes = totalSize;
+}
+
+void ResultCache::clear()
+{
+    entries.clear();
+    index.clear();
+}
+
+std::size_t ResultCache::size() const
+{
+    return entries.size();
+}
+
+std::size_t ResultCache::capacity() const
+{
+    return maxEntries;
+}
+
+const std::string& ResultCache::directory() const
+{
+    return cacheDirectory;
+}
+
+std::uintmax_t ResultCache::diskLimit() const
+{
+    return maxDiskBytes;
+}
+
+ResultCache::Statistics ResultCache::statistics() const
+{
+    return stats;
+}
@@ -0,0 +1,194 @@
+#include "../include/ResultCache.h"
+#include "TestHarness.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <cstdio>
+
+namespace {
+
+const ResultCache::Ring square = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+const ResultCache::Ring triangle = {{2, 2}, {6, 2}, {4, 6}};
+
+// A fresh directory per call, so concurrent test runs never share one
+std::string makeTempDirectory()
+{
+    std::random_device random;
+    char name[64];
+    std::snprintf(name, sizeof(name), "result_cache_test-%08x%08x", random(), random());
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+    std::filesystem::create_directories(directory);
+    return directory.string();
+}
+
+void testEquivalentRingsShareKey()
+{
+    std::string key = ResultCache::makeKey(BooleanOperations::UNION, square, triangle);
+
+    ResultCache::Ring rotated = {{4, 4}, {0, 4}, {0, 0}, {4, 0}};
+    ResultCache::Ring reversed = {{0, 0}, {0, 4}, {4, 4}, {4, 0}};
+    ResultCache::Ring duplicated = {{0, 0}, {4, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}};
+    ResultCache::Ring negativeZero = {{-0.0, 0}, {4, -0.0}, {4, 4}, {0, 4}};
+
+    CHECK(ResultCache::makeKey(BooleanOperations::UNION, rotated, triangle) == key);
+    CHECK(ResultCache::makeKey(BooleanOperations::UNION, reversed, triangle) == key);
+    CHECK(ResultCache::makeKey(BooleanOperations::UNION, duplicated, triangle) == key);
+    CHECK(ResultCache::makeKey(BooleanOperations::UNION, negativeZero, triangle) == key);
+}
+
+void testDifferentInputsHaveDifferentKeys()
+{
+    std::string key = ResultCache::makeKey(BooleanOperations::UNION, square, triangle);
+    ResultCache::Ring moved = {{0, 0}, {4, 0}, {4, 4}, {0, 5}};
+
+    CHECK(ResultCache::makeKey(BooleanOperations::INTERSECTION, square, triangle) != key);
+    CHECK(ResultCache::makeKey(BooleanOperations::UNION, triangle, square) != key);
+    CHECK(ResultCache::makeKey(BooleanOperations::UNION, moved, triangle) != key);
+    CHECK(ResultCache::makeKey(BooleanOperations::UNION, square, triangle, true) != key);
+
+    // Trusted rings are keyed as given
+    ResultCache::Ring reversed = {{0, 0}, {0, 4}, {4, 4}, {4, 0}};
+    CHECK(ResultCache::makeKey(BooleanOperations::UNION, reversed, triangle, true) !=
+        ResultCache::makeKey(BooleanOperations::UNION, square, triangle, true));
+}
+
+void testLruEviction()
+{
+    ResultCache cache(2);
+    ResultCache::Result result = {{square, {}}};
+    std::string keyA = ResultCache::makeKey(BooleanOperations::UNION, square, triangle);
+    std::string keyB = ResultCache::makeKey(BooleanOperations::INTERSECTION, square, triangle);
+    std::string keyC = ResultCache::makeKey(BooleanOperations::DIFFERENCE, square, triangle);
+
+    ResultCache::Result found;
+    CHECK(!cache.lookup(keyA, found));
+    cache.store(keyA, result);
+    cache.store(keyB, result);
+    CHECK(cache.lookup(keyA, found));  // keyB is now the least recently used
+    cache.store(keyC, result);
+
+    CHECK(cache.size() == 2);
+    CHECK(cache.lookup(keyA, found));
+    CHECK(!cache.lookup(keyB, found));
+
+    ResultCache::Statistics stats = cache.statistics();
+    CHECK(stats.hits == 2);
+    CHECK(stats.misses == 2);
+    CHECK(stats.evictions == 1);
+}
+
+void testDiskRoundTrip()
+{
+    std::string directory = makeTempDirectory();
+    std::string key = ResultCache::makeKey(BooleanOperations::SYMMETRIC_DIFFERENCE, square, triangle);
+    ResultCache::Result result = {{square, {triangle}}, {triangle, {}}};
+
+    {
+        ResultCache writer(4, directory);
+        writer.store(key, result);
+    }
+
+    ResultCache reader(4, directory);
+    ResultCache::Result found;
+    CHECK(reader.lookup(key, found));
+    CHECK(reader.statistics().diskHits == 1);
+    CHECK(found.size() == 2);
+    CHECK(found.size() == 2 && found[0].outer == square && found[0].holes.size() == 1 && found[0].holes[0] == triangle);
+    CHECK(found.size() == 2 && found[1].outer == triangle && found[1].holes.empty());
+
+    std::filesystem::remove_all(directory);
+}
+
+void testCorruptDiskEntryIsMiss()
+{
+    std::string directory = makeTempDirectory();
+    std::string key = ResultCache::makeKey(BooleanOperations::UNION, square, triangle);
+    {
+        ResultCache writer(4, directory);
+        writer.store(key, ResultCache::Result{{square, {}}});
+    }
+
+    // Flip one byte of the last stored coordinate
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::string bytes;
+        {
+            std::ifstream in(entry.path(), std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        bytes.back() ^= 1;
+        std::ofstream out(entry.path(), std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    ResultCache reader(4, directory);
+    ResultCache::Result found;
+    CHECK(!reader.lookup(key, found));
+
+    std::filesystem::remove_all(directory);
+}
+
+void testBooleanOperationsConsultCache()
+{
+    ResultCache cache;
+    BooleanOperations operations;
+    operations.setResultCache(&cache);
+    CHECK(operations.resultCache() == &cache);
+
+    auto first = operations.performUnion(square, triangle);
+    CHECK(!first.empty());
+    CHECK(cache.statistics().misses == 1);
+    CHECK(cache.statistics().hits == 0);
+
+    auto second = operations.performUnion(square, triangle);
+    CHECK(cache.statistics().hits == 1);
+    CHECK(second == first);
+
+    // Equivalent untrusted rings reuse the entry
+    ResultCache::Ring rotated = {{4, 4}, {0, 4}, {0, 0}, {4, 0}};
+    ResultCache::Ring reversed = {{0, 0}, {0, 4}, {4, 4}, {4, 0}};
+    CHECK(operations.performUnion(rotated, triangle) == first);
+    CHECK(operations.performUnion(reversed, triangle) == first);
+    CHECK(cache.statistics().hits == 3);
+    CHECK(cache.statistics().misses == 1);
+
+    // A different operation on the same input is a separate entry
+    operations.performIntersection(square, triangle);
+    CHECK(cache.statistics().misses == 2);
+}
+
+void testTrustModesDoNotShareEntries()
+{
+    ResultCache cache;
+    BooleanOperations operations;
+    operations.setResultCache(&cache);
+
+    operations.setTrustedInput(true);
+    auto trusted = operations.performUnion(square, triangle);
+    CHECK(cache.statistics().misses == 1);
+
+    operations.setTrustedInput(false);
+    auto untrusted = operations.performUnion(square, triangle);
+    CHECK(!untrusted.empty());
+    CHECK(cache.statistics().misses == 2);
+    CHECK(cache.statistics().hits == 0);
+
+    operations.setTrustedInput(true);
+    CHECK(operations.performUnion(square, triangle) == trusted);
+    CHECK(cache.statistics().hits == 1);
+}
+
+} // namespace
+
+int main()
+{
+    testEquivalentRingsShareKey();
+    testDifferentInputsHaveDifferentKeys();
+    testLruEviction();
+    testDiskRoundTrip();
+    testCorruptDiskEntryIsMiss();
+    testBooleanOperationsConsultCache();
+    testTrustModesDoNotShareEntries();
+
+    return testResult("result cache");
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <iostream>
+
+// Minimal check harness shared by the test executables. A failed CHECK is reported
+// and counted; the test's main() returns testResult() so CTest sees the failure.
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++testFailures(); \
+        } \
+    } while (0)
+
+inline int testResult(const char* suite)
+{
+    if (testFailures() > 0) {
+        std::cerr << testFailures() << " " << suite << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All " << suite << " tests passed" << std::endl;
+    return 0;
+}
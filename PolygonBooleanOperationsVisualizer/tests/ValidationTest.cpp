@@ -0,0 +1,266 @@
+#include "../include/BooleanOperations.h"
+#include "../include/ResultCache.h"
+#include "TestHarness.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+BooleanOperations::Polygon_2 makePolygon(const std::vector<std::pair<double, double>>& points)
+{
+    BooleanOperations::Polygon_2 polygon;
+    for (const auto& point : points) {
+        polygon.push_back(BooleanOperations::Point_2(point.first, point.second));
+    }
+    return polygon;
+}
+
+double totalArea(const BooleanOperations::Polygon_list& polygons)
+{
+    double area = 0.0;
+    for (const auto& poly : polygons) {
+        area += CGAL::to_double(poly.outer_boundary().area());
+        for (auto hole_it = poly.holes_begin(); hole_it != poly.holes_end(); ++hole_it) {
+            area -= std::fabs(CGAL::to_double(hole_it->area()));
+        }
+    }
+    return area;
+}
+
+bool allCounterclockwise(const BooleanOperations::Polygon_list& polygons)
+{
+    for (const auto& poly : polygons) {
+        if (!poly.outer_boundary().is_simple() || !poly.outer_boundary().is_counterclockwise_oriented()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testDuplicateVertices()
+{
+    BooleanOperations operations;
+    auto result = operations.validatePolygon(makePolygon({{0, 0}, {4, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}}));
+    CHECK(result.size() == 1);
+    CHECK(result.front().outer_boundary().size() == 4);
+    CHECK(totalArea(result) == 16.0);
+}
+
+void testClockwiseInput()
+{
+    BooleanOperations operations;
+    auto result = operations.validatePolygon(makePolygon({{0, 0}, {0, 4}, {4, 4}, {4, 0}}));
+    CHECK(result.size() == 1);
+    CHECK(allCounterclockwise(result));
+    CHECK(totalArea(result) == 16.0);
+}
+
+void testDegenerateInput()
+{
+    BooleanOperations operations;
+    CHECK(operations.validatePolygon(makePolygon({{0, 0}, {4, 0}, {4, 0}, {0, 0}})).empty());
+}
+
+void testBowtie()
+{
+    // Two triangles of area 1 meeting at (1, 1)
+    BooleanOperations operations;
+    auto result = operations.validatePolygon(makePolygon({{0, 0}, {2, 2}, {2, 0}, {0, 2}}));
+    CHECK(!result.empty());
+    CHECK(allCounterclockwise(result));
+    CHECK(totalArea(result) == 2.0);
+}
+
+void testSpike()
+{
+    // A square with a zero-width spike that goes out and comes back along the same edge
+    BooleanOperations operations;
+    auto result = operations.validatePolygon(makePolygon({{0, 0}, {4, 0}, {4, 4}, {6, 4}, {4, 4}, {0, 4}}));
+    CHECK(result.size() == 1);
+    CHECK(allCounterclockwise(result));
+    CHECK(totalArea(result) == 16.0);
+}
+
+void testOperationOnRepairedInput()
+{
+    // The bowtie's two triangles cover the clockwise triangle, so the union is the bowtie
+    BooleanOperations operations;
+    BooleanOperations::Polygon_list result;
+    operations.performUnion(
+        std::vector<std::pair<double, double>>{{0, 0}, {2, 2}, {2, 0}, {0, 2}},
+        std::vector<std::pair<double, double>>{{0, 0}, {0, 2}, {1, 1}},
+        [&result](const BooleanOperations::Polygon_with_holes_2& poly) { result.push_back(poly); });
+    CHECK(allCounterclockwise(result));
+    CHECK(totalArea(result) == 2.0);
+}
+
+// A square cut by a horizontal bar, so difference and symmetric difference have several components
+const std::vector<std::pair<double, double>> square = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+const std::vector<std::pair<double, double>> bar = {{-1, 1}, {5, 1}, {5, 2}, {-1, 2}};
+
+const BooleanOperations::OperationType allOperations[] = {
+    BooleanOperations::UNION,
+    BooleanOperations::INTERSECTION,
+    BooleanOperations::DIFFERENCE,
+    BooleanOperations::SYMMETRIC_DIFFERENCE
+};
+
+BooleanOperations::Polygon_list referenceResult(BooleanOperations::OperationType operation)
+{
+    BooleanOperations operations;
+    BooleanOperations::Polygon_2 polygonA = makePolygon(square);
+    BooleanOperations::Polygon_2 polygonB = makePolygon(bar);
+    BooleanOperations::Polygon_list result;
+    switch (operation) {
+        case BooleanOperations::UNION:
+            result = operations.performUnion(polygonA, polygonB);
+            break;
+        case BooleanOperations::INTERSECTION:
+            CGAL::intersection(polygonA, polygonB, std::back_inserter(result));
+            break;
+        case BooleanOperations::DIFFERENCE:
+            CGAL::difference(polygonA, polygonB, std::back_inserter(result));
+            break;
+        case BooleanOperations::SYMMETRIC_DIFFERENCE:
+            CGAL::symmetric_difference(polygonA, polygonB, std::back_inserter(result));
+            break;
+    }
+    return result;
+}
+
+BooleanOperations::Polygon_list streamedResult(BooleanOperations& operations, BooleanOperations::OperationType operation)
+{
+    BooleanOperations::Polygon_list result;
+    auto collect = [&result](const BooleanOperations::Polygon_with_holes_2& poly) { result.push_back(poly); };
+    switch (operation) {
+        case BooleanOperations::UNION:
+            operations.performUnion(square, bar, collect);
+            break;
+        case BooleanOperations::INTERSECTION:
+            operations.performIntersection(square, bar, collect);
+            break;
+        case BooleanOperations::DIFFERENCE:
+            operations.performDifference(square, bar, collect);
+            break;
+        case BooleanOperations::SYMMETRIC_DIFFERENCE:
+            operations.performSymmetricDifference(square, bar, collect);
+            break;
+    }
+    return result;
+}
+
+std::vector<std::vector<std::pair<double, double>>> streamedBoundaries(
+    BooleanOperations& operations, BooleanOperations::OperationType operation)
+{
+    std::vector<std::vector<std::pair<double, double>>> boundaries;
+    operations.performOperation(operation, square, bar,
+        [&boundaries](const std::vector<std::pair<double, double>>& boundary) { boundaries.push_back(boundary); });
+    return boundaries;
+}
+
+double outerArea(const BooleanOperations::Polygon_list& polygons)
+{
+    double area = 0.0;
+    for (const auto& poly : polygons) {
+        area += CGAL::to_double(poly.outer_boundary().area());
+    }
+    return area;
+}
+
+double boundaryArea(const std::vector<std::vector<std::pair<double, double>>>& boundaries)
+{
+    double area = 0.0;
+    for (const auto& boundary : boundaries) {
+        for (std::size_t i = 0; i < boundary.size(); ++i) {
+            const auto& p = boundary[i];
+            const auto& q = boundary[(i + 1) % boundary.size()];
+            area += (p.first * q.second - q.first * p.second) / 2.0;
+        }
+    }
+    return area;
+}
+
+void testStreamingMatchesListResult()
+{
+    // Each streaming overload must bypass the cache and match the list result every time
+    ResultCache cache;
+    BooleanOperations operations;
+    operations.setResultCache(&cache);
+
+    for (BooleanOperations::OperationType operation : allOperations) {
+        BooleanOperations::Polygon_list reference = referenceResult(operation);
+        for (int run = 0; run < 2; ++run) {
+            BooleanOperations::Polygon_list streamed = streamedResult(operations, operation);
+            CHECK(streamed.size() == reference.size());
+            CHECK(totalArea(streamed) == totalArea(reference));
+        }
+    }
+    CHECK(cache.statistics().hits == 0);
+    CHECK(cache.statistics().misses == 0);
+}
+
+void testBoundaryStreamingThroughCache()
+{
+    ResultCache cache;
+    BooleanOperations operations;
+    operations.setResultCache(&cache);
+
+    for (BooleanOperations::OperationType operation : allOperations) {
+        BooleanOperations::Polygon_list reference = referenceResult(operation);
+        ResultCache::Statistics before = cache.statistics();
+
+        auto miss = streamedBoundaries(operations, operation);
+        CHECK(cache.statistics().misses == before.misses + 1);
+        CHECK(cache.statistics().hits == before.hits);
+
+        auto hit = streamedBoundaries(operations, operation);
+        CHECK(cache.statistics().misses == before.misses + 1);
+        CHECK(cache.statistics().hits == before.hits + 1);
+
+        CHECK(miss.size() == reference.size());
+        CHECK(boundaryArea(miss) == outerArea(reference));
+        CHECK(hit == miss);
+    }
+    CHECK(cache.statistics().misses == 4);
+    CHECK(cache.statistics().hits == 4);
+}
+
+void testThrowingCallbackStoresNothing()
+{
+    ResultCache cache;
+    BooleanOperations operations;
+    operations.setResultCache(&cache);
+
+    bool threw = false;
+    try {
+        operations.performOperation(BooleanOperations::DIFFERENCE, square, bar,
+            [](const std::vector<std::pair<double, double>>&) { throw std::runtime_error("consumer failed"); });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(cache.size() == 0);
+
+    // The next call recomputes instead of replaying a partial result
+    auto boundaries = streamedBoundaries(operations, BooleanOperations::DIFFERENCE);
+    CHECK(boundaries.size() == referenceResult(BooleanOperations::DIFFERENCE).size());
+    CHECK(cache.statistics().hits == 0);
+    CHECK(cache.statistics().misses == 2);
+}
+
+} // namespace
+
+int main()
+{
+    testDuplicateVertices();
+    testClockwiseInput();
+    testDegenerateInput();
+    testBowtie();
+    testSpike();
+    testOperationOnRepairedInput();
+    testStreamingMatchesListResult();
+    testBoundaryStreamingThroughCache();
+    testThrowingCallbackStoresNothing();
+
+    return testResult("validation");
+}